@@ -1,5 +1,6 @@
 #include "remote_scales.h"
 #include "remote_scales_plugin_registry.h"
+#include "remote_scales_shot_log.h"
 
 // ---------------------------------------------------------------------------------------
 // ------------------------   Common RemoteScales methods    ------------------------------
@@ -20,6 +21,10 @@ void RemoteScales::setWeight(float newWeight) {
   float previousWeight = weight;
   weight = newWeight;
 
+  if (shotRecorder != nullptr) {
+    shotRecorder->addSample(millis(), newWeight);
+  }
+
   if (weightCallback == nullptr) {
     return;
   }
@@ -29,6 +34,12 @@ void RemoteScales::setWeight(float newWeight) {
   weightCallback(newWeight);
 }
 
+void RemoteScales::notifyConnectionStateChanged() {
+  if (scanner != nullptr) {
+    scanner->reevaluateScanProfile();
+  }
+}
+
 void RemoteScales::setWeightUpdatedCallback(void (*callback)(float), bool onlyChanges) {
   weightCallbackOnlyChanges = onlyChanges;
   this->weightCallback = callback;
@@ -38,15 +49,30 @@ void RemoteScales::setWeightUpdatedCallback(void (*callback)(float), bool onlyCh
 // ------------------------   RemoteScales methods    ------------------------------
 // ---------------------------------------------------------------------------------------
 
+RemoteScalesScanner::RemoteScalesScanner() : plugins(RemoteScalesPluginRegistry::getInstance()) {}
+
+RemoteScalesScanner::~RemoteScalesScanner() {
+  stopAsyncScan();
+  // Discovered scales may outlive the scanner, so they must stop reporting to it.
+  std::lock_guard<std::mutex> lock(discoveredScalesMutex);
+  for (const auto& scale : discoveredScales) {
+    scale->scanner = nullptr;
+  }
+}
+
+std::vector<RemoteScales*> RemoteScalesScanner::getDiscoveredScales() {
+  std::lock_guard<std::mutex> lock(discoveredScalesMutex);
+  return discoveredScales;
+}
+
 void RemoteScalesScanner::initializeAsyncScan() {
   if (isRunning) return;
   cleanupDiscoveredScales();
 
-  BLEDevice::getScan()->setAdvertisedDeviceCallbacks(this);
-  BLEDevice::getScan()->setInterval(200);
-  BLEDevice::getScan()->setWindow(100);
-  BLEDevice::getScan()->setActiveScan(false);
-  BLEDevice::getScan()->start(0, [](BLEScanResults) {}); // Set to 0 for continuous
+  BLEScan* scanner = BLEDevice::getScan();
+  scanner->setAdvertisedDeviceCallbacks(this);
+  applyScanProfile(scanner, selectScanProfile());
+  scanner->start(0, [](BLEScanResults) {}); // Set to 0 for continuous
   isRunning = true;
 }
 
@@ -62,14 +88,36 @@ void RemoteScalesScanner::restartAsyncScan() {
   initializeAsyncScan();
 }
 
+void RemoteScalesScanner::update() {
+  aggressiveDiscovery = true;
+  reevaluateScanProfile();
+}
+
+void RemoteScalesScanner::reevaluateScanProfile() {
+  if (!isRunning) return;
+
+  RemoteScalesScanProfile profile = selectScanProfile();
+  if (profile == scanProfile) return;
+
+  // Scan parameters only take effect on start, so restart the scan without clearing
+  // results. Already discovered devices are therefore not reported a second time.
+  BLEScan* scanner = BLEDevice::getScan();
+  scanner->stop();
+  applyScanProfile(scanner, profile);
+  scanner->start(0, [](BLEScanResults) {}, true);
+}
+
 void RemoteScalesScanner::onResult(BLEAdvertisedDevice advertisedDevice) {
-  RemoteScales* newScales = RemoteScalesPluginRegistry::getInstance()->initialiseRemoteScales(advertisedDevice);
+  RemoteScales* newScales = plugins->initialiseRemoteScales(advertisedDevice);
   if (newScales != nullptr) {
+    newScales->scanner = this;
+    std::lock_guard<std::mutex> lock(discoveredScalesMutex);
     discoveredScales.push_back(newScales);
   }
 }
 
 void RemoteScalesScanner::cleanupDiscoveredScales() {
+  std::lock_guard<std::mutex> lock(discoveredScalesMutex);
   for (const auto& scale : discoveredScales) {
     delete scale;
   }
@@ -79,9 +127,8 @@ void RemoteScalesScanner::cleanupDiscoveredScales() {
 std::vector<RemoteScales*> RemoteScalesScanner::syncScan(uint16_t timeout) {
   BLEScan* scanner = BLEDevice::getScan();
   isRunning = true;
-  scanner->setActiveScan(true);
-  scanner->setInterval(100);
-  scanner->setWindow(99);
+  RemoteScalesScanProfile previousProfile = scanProfile;
+  applyScanProfile(scanner, RemoteScalesScanProfile::AGGRESSIVE);
 
   BLEScanResults scanResults = scanner->start(timeout, false);
 
@@ -94,9 +141,57 @@ std::vector<RemoteScales*> RemoteScalesScanner::syncScan(uint16_t timeout) {
   scanner->setActiveScan(false);
 
   isRunning = false;
+  scanProfile = previousProfile;
   return scales;
 }
 
 bool RemoteScalesScanner::isScanRunning() {
   return isRunning;
 }
+
+RemoteScalesScanProfile RemoteScalesScanner::selectScanProfile() {
+  if (hasConnectedScales()) {
+    return RemoteScalesScanProfile::BACKGROUND;
+  }
+  std::lock_guard<std::mutex> lock(discoveredScalesMutex);
+  if (aggressiveDiscovery && discoveredScales.empty()) {
+    return RemoteScalesScanProfile::AGGRESSIVE;
+  }
+  return RemoteScalesScanProfile::BASELINE;
+}
+
+void RemoteScalesScanner::applyScanProfile(BLEScan* scanner, RemoteScalesScanProfile profile) {
+  // Active scanning costs a scan request/response exchange per device, so only do it
+  // when a plugin needs the scan response to identify its scales.
+  bool activeScan = plugins->requiresActiveScan();
+
+  switch (profile) {
+  case RemoteScalesScanProfile::AGGRESSIVE:
+    scanner->setInterval(100);
+    scanner->setWindow(99);
+    break;
+  case RemoteScalesScanProfile::BASELINE:
+    scanner->setInterval(200);
+    scanner->setWindow(100);
+    break;
+  case RemoteScalesScanProfile::BACKGROUND:
+    // ~2% duty cycle, leaving the radio to the connection's notifications.
+    scanner->setInterval(1280);
+    scanner->setWindow(30);
+    activeScan = false;
+    break;
+  }
+
+  scanner->setActiveScan(activeScan);
+  scanProfile = profile;
+}
+
+bool RemoteScalesScanner::hasConnectedScales() {
+  std::lock_guard<std::mutex> lock(discoveredScalesMutex);
+  for (const auto& scale : discoveredScales) {
+    if (scale->isConnected()) {
+      return true;
+    }
+  }
+  return false;
+}
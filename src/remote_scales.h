@@ -4,6 +4,10 @@
 #include <BLEDevice.h>
 #include <Arduino.h>
 #include <vector>
+#include <mutex>
+
+class ShotLogRecorder;
+class RemoteScalesScanner;
 
 class RemoteScales {
 
@@ -15,6 +19,8 @@ public:
 
   void setWeightUpdatedCallback(void (*callback)(float), bool onlyChanges = false);
   void setLogCallback(LogCallback logCallback) { this->logCallback = logCallback; }
+  // Every received weight is fed to the recorder. It only stores samples while a shot is being recorded.
+  void setShotRecorder(ShotLogRecorder* shotRecorder) { this->shotRecorder = shotRecorder; }
 
   std::string getDeviceName() { return device.getName(); }
   std::string getDeviceAddress() { return device.getAddress().toString(); }
@@ -30,8 +36,11 @@ protected:
 
   void setWeight(float newWeight);
   void log(std::string msgFormat, ...);
+  // Should be called by implementations after connecting or disconnecting.
+  void notifyConnectionStateChanged();
 
 private:
+  friend class RemoteScalesScanner;
   using WeightCallback = void (*)(float);
 
   float weight = 0.f;
@@ -41,6 +50,9 @@ private:
   LogCallback logCallback;
   WeightCallback weightCallback;
   bool weightCallbackOnlyChanges = false;
+
+  ShotLogRecorder* shotRecorder = nullptr;
+  RemoteScalesScanner* scanner = nullptr;
 };
 
 
@@ -48,21 +60,53 @@ private:
 // ---------------------------   RemoteScalesScanner    -----------------------------------
 // ---------------------------------------------------------------------------------------
 
+class RemoteScalesPluginSource;
+
+enum class RemoteScalesScanProfile : uint8_t {
+  AGGRESSIVE, // No scale known and update() is being called. Scan near continuously to pick up a freshly powered-on scale.
+  BASELINE,   // Default duty cycle. Used while scales are known but not connected.
+  BACKGROUND, // A scale is connected. Scan sparsely so the connection gets the radio.
+};
+
 class RemoteScalesScanner : BLEAdvertisedDeviceCallbacks {
 private:
+  friend class RemoteScales;
+
   bool isRunning = false;
+  bool aggressiveDiscovery = false;
+  const RemoteScalesPluginSource* plugins;
+  RemoteScalesScanProfile scanProfile = RemoteScalesScanProfile::BASELINE;
   std::vector<RemoteScales*> discoveredScales;
+  std::mutex discoveredScalesMutex; // onResult() runs on the BLE task
   void cleanupDiscoveredScales();
   void onResult(BLEAdvertisedDevice advertisedDevice);
 
+  RemoteScalesScanProfile selectScanProfile();
+  void reevaluateScanProfile();
+  void applyScanProfile(BLEScan* scanner, RemoteScalesScanProfile profile);
+  bool hasConnectedScales();
+
 public:
-  std::vector<RemoteScales*> getDiscoveredScales() { return discoveredScales; }
+  // Uses the plugins applied to the RemoteScalesPluginRegistry singleton.
+  RemoteScalesScanner();
+  // Uses the given plugins, i.e. a compile-time RemoteScalesStaticPlugins table. Builds that only
+  // use this constructor never reference the singleton, so the linker can drop it.
+  explicit RemoteScalesScanner(const RemoteScalesPluginSource& plugins) : plugins(&plugins) {}
+  ~RemoteScalesScanner();
+
+  std::vector<RemoteScales*> getDiscoveredScales();
   std::vector<RemoteScales*> syncScan(uint16_t timeout);
 
   void initializeAsyncScan();
   void stopAsyncScan();
   void restartAsyncScan();
   bool isScanRunning();
+  RemoteScalesScanProfile getScanProfile() { return scanProfile; }
+
+  // Re-evaluates the async scan duty cycle. Connection changes of discovered scales are picked up
+  // without it, but calling it periodically (i.e. from loop()) also enables the AGGRESSIVE profile
+  // while no scale is known, as only polling can step back down once one is found.
+  void update();
 };
 
 #endif
@@ -0,0 +1,84 @@
+#include "remote_scales_command_queue.h"
+#include <algorithm>
+
+// ---------------------------------------------------------------------------------------
+// ------------------------   RemoteScalesCommandQueue    ---------------------------------
+// ---------------------------------------------------------------------------------------
+
+bool RemoteScalesCommandQueue::enqueue(const uint8_t* frame, size_t length, RemoteScalesCommandPriority priority, bool requiresResponse) {
+  if (frame == nullptr || length == 0) return false;
+
+  // Housekeeping frames are idempotent, so there is no point in queueing the same one twice.
+  if (priority == RemoteScalesCommandPriority::HOUSEKEEPING && containsFrame(housekeepingFrames, frame, length)) {
+    return true;
+  }
+
+  if (size() >= maxQueuedFrames) {
+    if (housekeepingFrames.empty()) {
+      // Only user commands are queued, so the link is not keeping up. Reject rather than reorder them.
+      droppedFrames++;
+      return false;
+    }
+    housekeepingFrames.pop_front();
+    droppedFrames++;
+  }
+
+  std::deque<Frame>& frames = priority == RemoteScalesCommandPriority::USER ? userFrames : housekeepingFrames;
+  frames.push_back(Frame{ std::vector<uint8_t>(frame, frame + length), requiresResponse });
+  return true;
+}
+
+size_t RemoteScalesCommandQueue::flush(const PacketWriter& write, size_t maxPacketSize) {
+  if (!write) return 0;
+
+  size_t packetsSent = 0;
+  Frame frame;
+  while (packetsSent < maxPacketsPerFlush && peekNextFrame() != nullptr) {
+    Frame* next = peekNextFrame();
+    if (!coalesceFrames || next->requiresResponse || next->bytes.size() >= maxPacketSize) {
+      popNextFrame(frame);
+      write(frame.bytes.data(), frame.bytes.size(), frame.requiresResponse);
+      packetsSent++;
+      continue;
+    }
+
+    packet.clear();
+    while (next != nullptr && !next->requiresResponse && packet.size() + next->bytes.size() <= maxPacketSize) {
+      popNextFrame(frame);
+      packet.insert(packet.end(), frame.bytes.begin(), frame.bytes.end());
+      next = peekNextFrame();
+    }
+    write(packet.data(), packet.size(), false);
+    packetsSent++;
+  }
+
+  return packetsSent;
+}
+
+void RemoteScalesCommandQueue::clear() {
+  userFrames.clear();
+  housekeepingFrames.clear();
+}
+
+bool RemoteScalesCommandQueue::containsFrame(const std::deque<Frame>& frames, const uint8_t* frame, size_t length) {
+  for (const auto& queued : frames) {
+    if (queued.bytes.size() == length && std::equal(queued.bytes.begin(), queued.bytes.end(), frame)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+RemoteScalesCommandQueue::Frame* RemoteScalesCommandQueue::peekNextFrame() {
+  if (!userFrames.empty()) return &userFrames.front();
+  if (!housekeepingFrames.empty()) return &housekeepingFrames.front();
+  return nullptr;
+}
+
+bool RemoteScalesCommandQueue::popNextFrame(Frame& frame) {
+  std::deque<Frame>& frames = !userFrames.empty() ? userFrames : housekeepingFrames;
+  if (frames.empty()) return false;
+  frame = std::move(frames.front());
+  frames.pop_front();
+  return true;
+}
@@ -0,0 +1,58 @@
+#ifndef REMOTE_SCALES_COMMAND_QUEUE_H
+#define REMOTE_SCALES_COMMAND_QUEUE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include <deque>
+
+enum class RemoteScalesCommandPriority : uint8_t {
+  HOUSEKEEPING = 0, // Heartbeats, notification requests etc. Can be coalesced or dropped under load.
+  USER = 1,         // Commands triggered by the user (i.e. tare). Always sent before housekeeping.
+};
+
+// Outbound command queue for a single scale.
+// Frames are sent as write-without-response unless a frame explicitly asks for a response.
+// If the scale's protocol parses commands as a byte stream, coalesceFrames packs consecutive
+// frames back to back into as few writes as the packet size allows.
+// There is no congestion feedback from the stack, so backpressure is a static rate limit:
+// each flush sends at most maxPacketsPerFlush packets and the queue holds at most
+// maxQueuedFrames frames, dropping housekeeping before user commands.
+class RemoteScalesCommandQueue {
+public:
+  // Sends a single packet, i.e. through BLERemoteCharacteristic::writeValue().
+  using PacketWriter = std::function<void(uint8_t* data, size_t length, bool withResponse)>;
+
+  RemoteScalesCommandQueue(bool coalesceFrames = true, size_t maxQueuedFrames = 16, size_t maxPacketsPerFlush = 4)
+    : coalesceFrames(coalesceFrames), maxQueuedFrames(maxQueuedFrames), maxPacketsPerFlush(maxPacketsPerFlush) {}
+
+  bool enqueue(const uint8_t* frame, size_t length, RemoteScalesCommandPriority priority, bool requiresResponse = false);
+  size_t flush(const PacketWriter& write, size_t maxPacketSize);
+  void clear();
+
+  size_t size() { return userFrames.size() + housekeepingFrames.size(); }
+  bool isEmpty() { return size() == 0; }
+  uint32_t getDroppedFrames() { return droppedFrames; }
+
+private:
+  struct Frame {
+    std::vector<uint8_t> bytes;
+    bool requiresResponse;
+  };
+
+  bool coalesceFrames;
+  size_t maxQueuedFrames;
+  size_t maxPacketsPerFlush;
+  uint32_t droppedFrames = 0;
+
+  std::deque<Frame> userFrames;
+  std::deque<Frame> housekeepingFrames;
+  std::vector<uint8_t> packet;
+
+  bool containsFrame(const std::deque<Frame>& frames, const uint8_t* frame, size_t length);
+  bool popNextFrame(Frame& frame);
+  Frame* peekNextFrame();
+};
+
+#endif
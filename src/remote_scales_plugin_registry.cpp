@@ -16,7 +16,7 @@ void RemoteScalesPluginRegistry::registerPlugin(RemoteScalesPlugin plugin) {
   plugins.push_back(plugin);
 }
 
-bool RemoteScalesPluginRegistry::containsPluginForDevice(BLEAdvertisedDevice device) {
+bool RemoteScalesPluginRegistry::containsPluginForDevice(BLEAdvertisedDevice device) const {
   for (const auto& plugin : plugins) {
     if (plugin.handles(device)) {
       return true;
@@ -25,7 +25,7 @@ bool RemoteScalesPluginRegistry::containsPluginForDevice(BLEAdvertisedDevice dev
   return false;
 }
 
-RemoteScales* RemoteScalesPluginRegistry::initialiseRemoteScales(BLEAdvertisedDevice device) {
+RemoteScales* RemoteScalesPluginRegistry::initialiseRemoteScales(BLEAdvertisedDevice device) const {
   for (const auto& plugin : plugins) {
     if (plugin.handles(device)) {
       return plugin.initialise(device);
@@ -34,3 +34,42 @@ RemoteScales* RemoteScalesPluginRegistry::initialiseRemoteScales(BLEAdvertisedDe
   return nullptr;
 }
 
+bool RemoteScalesPluginRegistry::requiresActiveScan() const {
+  for (const auto& plugin : plugins) {
+    if (plugin.requiresScanResponse) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// ---------------------------------------------------------------------------------------
+// ---------------------   RemoteScalesStaticPluginRegistry    ----------------------------
+// ---------------------------------------------------------------------------------------
+
+bool RemoteScalesStaticPluginRegistry::containsPluginForDevice(BLEAdvertisedDevice device) const {
+  for (size_t i = 0; i < count; i++) {
+    if (plugins[i].handles(device)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+RemoteScales* RemoteScalesStaticPluginRegistry::initialiseRemoteScales(BLEAdvertisedDevice device) const {
+  for (size_t i = 0; i < count; i++) {
+    if (plugins[i].handles(device)) {
+      return plugins[i].initialise(device);
+    }
+  }
+  return nullptr;
+}
+
+bool RemoteScalesStaticPluginRegistry::requiresActiveScan() const {
+  for (size_t i = 0; i < count; i++) {
+    if (plugins[i].requiresScanResponse) {
+      return true;
+    }
+  }
+  return false;
+}
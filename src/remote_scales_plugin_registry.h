@@ -9,9 +9,21 @@ struct RemoteScalesPlugin {
   std::string id;
   RemoteScalesFilter handles;
   RemoteScalesInitialiser initialise;
+  bool requiresScanResponse = false; // Set if the plugin can only identify its scales from scan response data
 };
 
-class RemoteScalesPluginRegistry {
+// Where a RemoteScalesScanner looks up the plugin for an advertised device.
+class RemoteScalesPluginSource {
+public:
+  virtual bool containsPluginForDevice(BLEAdvertisedDevice device) const = 0;
+  virtual RemoteScales* initialiseRemoteScales(BLEAdvertisedDevice device) const = 0;
+  virtual bool requiresActiveScan() const = 0;
+
+protected:
+  ~RemoteScalesPluginSource() = default; // Non-virtual so that static registries stay constexpr
+};
+
+class RemoteScalesPluginRegistry : public RemoteScalesPluginSource {
 public:
   static RemoteScalesPluginRegistry* getInstance() {
     if (instance == nullptr) {
@@ -24,8 +36,9 @@ public:
   void operator=(const RemoteScalesPluginRegistry&) = delete;
 
   void registerPlugin(RemoteScalesPlugin plugin);
-  bool containsPluginForDevice(BLEAdvertisedDevice device);
-  RemoteScales* initialiseRemoteScales(BLEAdvertisedDevice device);
+  bool containsPluginForDevice(BLEAdvertisedDevice device) const override;
+  RemoteScales* initialiseRemoteScales(BLEAdvertisedDevice device) const override;
+  bool requiresActiveScan() const override;
 
 private:
   static RemoteScalesPluginRegistry* instance;
@@ -33,4 +46,63 @@ private:
   RemoteScalesPluginRegistry() {}  // Private constructor to enforce singleton
 };
 
+// ---------------------------------------------------------------------------------------
+// ---------------------   RemoteScalesStaticPluginRegistry    ----------------------------
+// ---------------------------------------------------------------------------------------
+
+// Literal counterpart of RemoteScalesPlugin so that plugin tables can be built at compile time.
+struct RemoteScalesStaticPlugin {
+  const char* id;
+  RemoteScalesPlugin::RemoteScalesFilter handles;
+  RemoteScalesPlugin::RemoteScalesInitialiser initialise;
+  bool requiresScanResponse;
+};
+
+// Read-only view over a constant plugin table. Does no allocation and can live in flash.
+class RemoteScalesStaticPluginRegistry : public RemoteScalesPluginSource {
+public:
+  constexpr RemoteScalesStaticPluginRegistry(const RemoteScalesStaticPlugin* plugins, size_t count)
+    : plugins(plugins), count(count) {}
+
+  bool containsPluginForDevice(BLEAdvertisedDevice device) const override;
+  RemoteScales* initialiseRemoteScales(BLEAdvertisedDevice device) const override;
+  bool requiresActiveScan() const override;
+
+private:
+  const RemoteScalesStaticPlugin* plugins;
+  size_t count;
+};
+
+// Collects the given plugins into a constant table at compile time, i.e.
+//   RemoteScalesScanner scanner(RemoteScalesStaticPlugins<AcaiaScalesPlugin>::registry);
+// Each plugin type must provide a `static constexpr RemoteScalesStaticPlugin staticPlugin`.
+// Plugins that are not listed are never referenced and get dropped by the linker.
+template <typename... Plugins>
+class RemoteScalesStaticPlugins {
+  static_assert(sizeof...(Plugins) > 0, "At least one plugin is required");
+
+  static constexpr bool idsEqual(const char* a, const char* b) {
+    while (*a != '\0' && *a == *b) {
+      a++;
+      b++;
+    }
+    return *a == *b;
+  }
+
+  static constexpr bool hasDuplicateIds(const RemoteScalesStaticPlugin* table, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      for (size_t j = i + 1; j < count; j++) {
+        if (idsEqual(table[i].id, table[j].id)) return true;
+      }
+    }
+    return false;
+  }
+
+public:
+  static constexpr RemoteScalesStaticPlugin table[] = { Plugins::staticPlugin... };
+  static constexpr RemoteScalesStaticPluginRegistry registry{ table, sizeof...(Plugins) };
+
+  static_assert(!hasDuplicateIds(table, sizeof...(Plugins)), "Duplicate plugin id");
+};
+
 #endif
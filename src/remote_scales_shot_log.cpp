@@ -0,0 +1,320 @@
+#include "remote_scales_shot_log.h"
+#include <cmath>
+#include <cstring>
+
+enum class ShotLogControl : uint32_t {
+  SHOT_START = 1,
+  SHOT_END = 2,
+};
+
+static constexpr size_t MAX_VARINT_LENGTH = 5;
+
+static size_t encodeVarint(uint32_t value, uint8_t* out) {
+  size_t length = 0;
+  while (value >= 0x80) {
+    out[length++] = static_cast<uint8_t>(value | 0x80);
+    value >>= 7;
+  }
+  out[length++] = static_cast<uint8_t>(value);
+  return length;
+}
+
+static uint32_t encodeControl(ShotLogControl control) {
+  return (static_cast<uint32_t>(control) << 1) | 1;
+}
+
+static uint32_t zigzagEncode(int32_t value) {
+  return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int32_t zigzagDecode(uint32_t value) {
+  return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+// ---------------------------------------------------------------------------------------
+// --------------------------   FileShotLogStorage    ------------------------------------
+// ---------------------------------------------------------------------------------------
+
+FileShotLogStorage::~FileShotLogStorage() {
+  if (file != nullptr) {
+    fclose(file);
+  }
+}
+
+bool FileShotLogStorage::append(const uint8_t* data, size_t length) {
+  if (file == nullptr) return false;
+  // read() may have left the stream in input mode, and output must not directly follow input.
+  if (fseek(file, 0, SEEK_END) != 0) return false;
+  if (fwrite(data, 1, length, file) != length) return false;
+  return fflush(file) == 0;
+}
+
+size_t FileShotLogStorage::read(size_t offset, uint8_t* data, size_t length) {
+  if (file == nullptr) return 0;
+  if (fseek(file, static_cast<long>(offset), SEEK_SET) != 0) return 0;
+  return fread(data, 1, length, file);
+}
+
+// ---------------------------------------------------------------------------------------
+// ----------------------------   ShotLogRecorder    -------------------------------------
+// ---------------------------------------------------------------------------------------
+
+void ShotLogRecorder::startShot() {
+  if (isRecording()) {
+    endShot();
+  }
+  writePendingPage();
+
+  std::lock_guard<std::mutex> lock(mutex);
+  recording = true;
+  lastTimestamp = millis();
+  lastWeight = 0;
+
+  uint8_t record[2 * MAX_VARINT_LENGTH];
+  size_t length = encodeVarint(encodeControl(ShotLogControl::SHOT_START), record);
+  length += encodeVarint(lastTimestamp, record + length);
+  writeRecord(record, length);
+}
+
+void ShotLogRecorder::endShot() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!recording) return;
+    recording = false;
+  }
+
+  // addSample() no longer touches the pages, so the rest runs without contention.
+  writePendingPage();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint8_t record[MAX_VARINT_LENGTH];
+    size_t length = encodeVarint(encodeControl(ShotLogControl::SHOT_END), record);
+    writeRecord(record, length);
+  }
+  flush();
+}
+
+void ShotLogRecorder::update() {
+  writePendingPage();
+}
+
+void ShotLogRecorder::addSample(uint32_t timestamp, float weight) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!recording) return;
+
+  // Samples are stamped on the BLE task and may race with startShot(), so never go back in time.
+  int32_t elapsed = static_cast<int32_t>(timestamp - lastTimestamp);
+  uint32_t delta = elapsed < 0 ? 0 : static_cast<uint32_t>(elapsed);
+  int32_t centigrams = static_cast<int32_t>(lroundf(weight * 100.f));
+
+  uint8_t record[MAX_RECORD_SIZE];
+  size_t length = encodeVarint(delta << 1, record);
+  length += encodeVarint(zigzagEncode(centigrams - lastWeight), record + length);
+  if (!writeRecord(record, length)) {
+    droppedSamples++;
+    return;
+  }
+
+  lastTimestamp += delta;
+  lastWeight = centigrams;
+}
+
+bool ShotLogRecorder::isRecording() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return recording;
+}
+
+uint32_t ShotLogRecorder::getBytesEncoded() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return bytesEncoded;
+}
+
+uint32_t ShotLogRecorder::getBytesWritten() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return bytesWritten;
+}
+
+uint32_t ShotLogRecorder::getFailedWrites() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return failedWrites;
+}
+
+uint32_t ShotLogRecorder::getDroppedSamples() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return droppedSamples;
+}
+
+bool ShotLogRecorder::writeRecord(const uint8_t* record, size_t length) {
+  if (pageLength + length > PAGE_SIZE && !sealActivePage()) {
+    return false;
+  }
+  memcpy(pages[activePage] + pageLength, record, length);
+  pageLength += length;
+  bytesEncoded += length;
+  return true;
+}
+
+bool ShotLogRecorder::sealActivePage() {
+  if (pageLength == PAGE_HEADER_SIZE) return true;
+  if (pagePending) return false;
+
+  uint8_t* page = pages[activePage];
+  page[0] = static_cast<uint8_t>(pageLength & 0xFF);
+  page[1] = static_cast<uint8_t>(pageLength >> 8);
+  memset(page + pageLength, 0, PAGE_SIZE - pageLength);
+
+  pagePending = true;
+  activePage = 1 - activePage;
+  pageLength = PAGE_HEADER_SIZE;
+  return true;
+}
+
+void ShotLogRecorder::writePendingPage() {
+  const uint8_t* page;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!pagePending) return;
+    page = pages[1 - activePage];
+  }
+
+  // The pending page is left alone by addSample() until it is released below.
+  bool written = storage.append(page, PAGE_SIZE);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  pagePending = false;
+  if (written) {
+    bytesWritten += PAGE_SIZE;
+  }
+  else {
+    failedWrites++;
+  }
+}
+
+void ShotLogRecorder::flush() {
+  writePendingPage();
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    sealActivePage();
+  }
+  writePendingPage();
+}
+
+// ---------------------------------------------------------------------------------------
+// -----------------------------   ShotLogReader    --------------------------------------
+// ---------------------------------------------------------------------------------------
+
+bool ShotLogReader::nextShot(uint32_t& startTimestamp) {
+  if (hasPendingShotStart) {
+    hasPendingShotStart = false;
+    startTimestamp = pendingShotStart;
+  }
+  else {
+    uint32_t first = 0;
+    uint32_t second = 0;
+    RecordType type;
+    do {
+      type = readRecord(first, second);
+    } while (type != RecordType::SHOT_START && type != RecordType::END_OF_LOG);
+
+    if (type == RecordType::END_OF_LOG) {
+      inShot = false;
+      return false;
+    }
+    startTimestamp = first;
+  }
+
+  inShot = true;
+  elapsed = 0;
+  weight = 0;
+  return true;
+}
+
+bool ShotLogReader::nextSample(ShotLogSample& sample) {
+  if (!inShot) return false;
+
+  uint32_t first = 0;
+  uint32_t second = 0;
+  RecordType type = readRecord(first, second);
+
+  if (type == RecordType::SAMPLE) {
+    elapsed += first;
+    weight += zigzagDecode(second);
+    sample.timestamp = elapsed;
+    sample.weight = weight / 100.f;
+    return true;
+  }
+
+  if (type == RecordType::SHOT_START) {
+    // The previous shot was never ended (i.e. power loss). Keep the new one for nextShot().
+    hasPendingShotStart = true;
+    pendingShotStart = first;
+  }
+  inShot = false;
+  return false;
+}
+
+bool ShotLogReader::loadNextPage() {
+  if (storage.read(nextPageOffset, page, ShotLogRecorder::PAGE_SIZE) < ShotLogRecorder::PAGE_SIZE) {
+    return false;
+  }
+  nextPageOffset += ShotLogRecorder::PAGE_SIZE;
+
+  pageLength = page[0] | (page[1] << 8);
+  if (pageLength > ShotLogRecorder::PAGE_SIZE) {
+    pageLength = ShotLogRecorder::PAGE_HEADER_SIZE; // Corrupt header, skip the page
+  }
+  pagePosition = ShotLogRecorder::PAGE_HEADER_SIZE;
+  return true;
+}
+
+bool ShotLogReader::readVarint(uint32_t& value) {
+  value = 0;
+  for (size_t i = 0; i < MAX_VARINT_LENGTH && pagePosition < pageLength; i++) {
+    uint8_t byte = page[pagePosition++];
+    value |= static_cast<uint32_t>(byte & 0x7F) << (7 * i);
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+ShotLogReader::RecordType ShotLogReader::readRecord(uint32_t& first, uint32_t& second) {
+  while (true) {
+    while (pagePosition >= pageLength) {
+      if (!loadNextPage()) {
+        return RecordType::END_OF_LOG;
+      }
+    }
+
+    uint32_t head = 0;
+    if (!readVarint(head)) {
+      pagePosition = pageLength;
+      continue;
+    }
+
+    if ((head & 1) == 0) {
+      first = head >> 1;
+      if (!readVarint(second)) {
+        pagePosition = pageLength;
+        continue;
+      }
+      return RecordType::SAMPLE;
+    }
+
+    if (head == encodeControl(ShotLogControl::SHOT_START)) {
+      if (!readVarint(first)) {
+        pagePosition = pageLength;
+        continue;
+      }
+      return RecordType::SHOT_START;
+    }
+
+    if (head == encodeControl(ShotLogControl::SHOT_END)) {
+      return RecordType::SHOT_END;
+    }
+
+    // Unknown record, the rest of the page cannot be decoded reliably.
+    pagePosition = pageLength;
+  }
+}
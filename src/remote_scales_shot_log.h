@@ -0,0 +1,149 @@
+#ifndef REMOTE_SCALES_SHOT_LOG_H
+#define REMOTE_SCALES_SHOT_LOG_H
+
+#include <Arduino.h>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <mutex>
+
+// ---------------------------------------------------------------------------------------
+// ----------------------------   ShotLogStorage    --------------------------------------
+// ---------------------------------------------------------------------------------------
+
+// Append-only byte storage the shot log is written to. Writes are always whole pages.
+class ShotLogStorage {
+public:
+  virtual ~ShotLogStorage() {}
+  virtual bool append(const uint8_t* data, size_t length) = 0;
+  virtual size_t read(size_t offset, uint8_t* data, size_t length) = 0;
+};
+
+// Storage backed by a single file. Works on Linux as well as on any mounted ESP32 VFS.
+class FileShotLogStorage : public ShotLogStorage {
+public:
+  FileShotLogStorage(const std::string& path) : file(fopen(path.c_str(), "a+b")) {}
+  ~FileShotLogStorage() override;
+
+  FileShotLogStorage(FileShotLogStorage& other) = delete;
+  void operator=(const FileShotLogStorage&) = delete;
+
+  bool isOpen() { return file != nullptr; }
+  bool append(const uint8_t* data, size_t length) override;
+  size_t read(size_t offset, uint8_t* data, size_t length) override;
+
+private:
+  FILE* file;
+};
+
+// ---------------------------------------------------------------------------------------
+// ----------------------------   ShotLogRecorder    -------------------------------------
+// ---------------------------------------------------------------------------------------
+
+// The log is a sequence of fixed-size pages. Each page starts with its used length
+// (2 bytes, little endian) followed by records that never span pages:
+//   sample:     varint(dt << 1), zigzag varint(dw)   dt in ms, dw in centigrams
+//   shot start: varint(1 << 1 | 1), varint(start timestamp in ms)
+//   shot end:   varint(2 << 1 | 1)
+// Deltas are relative to the previous sample of the shot, or to (start timestamp, 0g).
+//
+// addSample() is called from the BLE task and never touches storage. It fills one of two
+// pages in RAM and hands full pages over to update(), which writes them from the user's task.
+// If update() falls behind so that both pages are full, samples are dropped.
+//
+// Every written page is either filled to within MAX_RECORD_SIZE - 1 bytes or is the last page
+// of a shot, so getBytesWritten() never exceeds
+//   getBytesEncoded() * PAGE_SIZE / (PAGE_SIZE - PAGE_HEADER_SIZE - MAX_RECORD_SIZE + 1) + shots * PAGE_SIZE
+class ShotLogRecorder {
+public:
+  static constexpr size_t PAGE_SIZE = 512;
+  static constexpr size_t PAGE_HEADER_SIZE = 2;
+  static constexpr size_t MAX_RECORD_SIZE = 10;
+
+  ShotLogRecorder(ShotLogStorage& storage) : storage(storage) {}
+
+  void startShot();
+  void endShot();
+  // Writes out pages filled by addSample(). Should be called periodically (i.e. from loop()).
+  void update();
+
+  void addSample(uint32_t timestamp, float weight);
+
+  bool isRecording();
+  uint32_t getBytesEncoded();
+  uint32_t getBytesWritten();
+  uint32_t getFailedWrites();
+  uint32_t getDroppedSamples();
+
+private:
+  ShotLogStorage& storage;
+  std::mutex mutex;
+
+  uint8_t pages[2][PAGE_SIZE];
+  size_t activePage = 0;
+  size_t pageLength = PAGE_HEADER_SIZE;
+  bool pagePending = false; // The inactive page is full and waiting to be written
+
+  bool recording = false;
+  uint32_t lastTimestamp = 0;
+  int32_t lastWeight = 0;
+
+  uint32_t bytesEncoded = 0;
+  uint32_t bytesWritten = 0;
+  uint32_t failedWrites = 0;
+  uint32_t droppedSamples = 0;
+
+  // Must be called with the mutex held.
+  bool writeRecord(const uint8_t* record, size_t length);
+  bool sealActivePage();
+
+  void writePendingPage();
+  void flush();
+};
+
+// ---------------------------------------------------------------------------------------
+// -----------------------------   ShotLogReader    --------------------------------------
+// ---------------------------------------------------------------------------------------
+
+struct ShotLogSample {
+  uint32_t timestamp; // ms since the start of the shot
+  float weight;       // grams
+};
+
+// Decodes shots back from storage, i.e.
+//   while (reader.nextShot(start)) { while (reader.nextSample(sample)) { ... } }
+class ShotLogReader {
+public:
+  ShotLogReader(ShotLogStorage& storage) : storage(storage) {}
+
+  bool nextShot(uint32_t& startTimestamp);
+  bool nextSample(ShotLogSample& sample);
+
+private:
+  enum class RecordType : uint8_t {
+    SAMPLE,
+    SHOT_START,
+    SHOT_END,
+    END_OF_LOG,
+  };
+
+  ShotLogStorage& storage;
+
+  uint8_t page[ShotLogRecorder::PAGE_SIZE];
+  size_t nextPageOffset = 0;
+  size_t pagePosition = 0;
+  size_t pageLength = 0;
+
+  bool inShot = false;
+  bool hasPendingShotStart = false;
+  uint32_t pendingShotStart = 0;
+  uint32_t elapsed = 0;
+  int32_t weight = 0;
+
+  bool loadNextPage();
+  bool readVarint(uint32_t& value);
+  RecordType readRecord(uint32_t& first, uint32_t& second);
+};
+
+#endif
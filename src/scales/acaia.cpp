@@ -49,6 +49,7 @@ bool AcaiaScales::connect() {
   }
 
   client.reset(BLEDevice::createClient());
+  commandQueue.clear();
   RemoteScales::log("Connecting to %s[%s]\n", RemoteScales::getDevice()->getName().c_str(), RemoteScales::getDevice()->getAddress().toString().c_str());
   bool result = client->connect(RemoteScales::getDevice());
   if (!result) {
@@ -63,6 +64,7 @@ bool AcaiaScales::connect() {
   }
   subscribeToNotifications();
   RemoteScales::setWeight(0.f);
+  RemoteScales::notifyConnectionStateChanged();
   return true;
 }
 
@@ -71,6 +73,8 @@ void AcaiaScales::disconnect() {
     RemoteScales::log("Disconnecting and cleaning up BLE client\n");
     client->disconnect();
     client.reset();
+    commandQueue.clear();
+    RemoteScales::notifyConnectionStateChanged();
     RemoteScales::log("Disconnected\n");
   }
 }
@@ -87,13 +91,18 @@ void AcaiaScales::update() {
     markedForReconnection = false;
   } else {
     sendHeartbeat();
+    flushCommands();
   }
 }
 
 bool AcaiaScales::tare() {
   if (!isConnected()) return false;
   uint8_t payload[] = { 0x00 };
-  sendMessage(AcaiaMessageType::TARE, payload, sizeof(payload));
+  if (!sendMessage(AcaiaMessageType::TARE, payload, sizeof(payload), RemoteScalesCommandPriority::USER)) {
+    RemoteScales::log("Command queue full - dropping tare\n");
+    return false;
+  }
+  flushCommands();
   return true;
 };
 
@@ -298,13 +307,20 @@ bool AcaiaScales::performConnectionHandshake() {
   RemoteScales::log("Send ID\n");
   sendNotificationRequest();
   RemoteScales::log("Sent notification request\n");
+  flushCommands();
   lastHeartbeat = millis();
   return true;
 }
 
-void AcaiaScales::sendMessage(AcaiaMessageType msgType, const uint8_t* payload, size_t length, bool waitResponse) {
+bool AcaiaScales::sendMessage(
+  AcaiaMessageType msgType,
+  const uint8_t* payload,
+  size_t length,
+  RemoteScalesCommandPriority priority,
+  bool waitResponse
+) {
   size_t bufferSize = 5 + length;
-  uint8_t* bytes = new uint8_t[bufferSize];
+  std::vector<uint8_t> bytes(bufferSize);
 
   bytes[0] = static_cast<uint8_t>(AcaiaHeader::HEADER1);
   bytes[1] = static_cast<uint8_t>(AcaiaHeader::HEADER2);
@@ -326,13 +342,24 @@ void AcaiaScales::sendMessage(AcaiaMessageType msgType, const uint8_t* payload,
   bytes[length + 3] = (cksum1 & 0xFF);
   bytes[length + 4] = (cksum2 & 0xFF);
 
-  // RemoteScales::log("Sending: %s\n", byteArrayToHexString(bytes, bufferSize).c_str());
-  commandCharacteristic->writeValue(bytes, bufferSize, waitResponse);
+  // RemoteScales::log("Queueing: %s\n", byteArrayToHexString(bytes.data(), bufferSize).c_str());
+  return commandQueue.enqueue(bytes.data(), bufferSize, priority, waitResponse);
 };
 
+void AcaiaScales::flushCommands() {
+  if (!isConnected() || commandCharacteristic == nullptr) {
+    return;
+  }
+  // The MTU exchange completes asynchronously after setMTU(), so read the negotiated value every time.
+  auto write = [this](uint8_t* data, size_t length, bool withResponse) {
+    commandCharacteristic->writeValue(data, length, withResponse);
+  };
+  commandQueue.flush(write, client->getMTU() - 3); // ATT write header
+}
+
 void AcaiaScales::sendId() {
   const uint8_t payload[] = { 0x2d,0x2d,0x2d,0x2d,0x2d,0x2d,0x2d,0x2d,0x2d,0x2d,0x2d,0x2d,0x2d,0x2d,0x2d };
-  sendMessage(AcaiaMessageType::IDENTIFY, payload, 15, false);
+  sendMessage(AcaiaMessageType::IDENTIFY, payload, 15);
 }
 
 void AcaiaScales::sendNotificationRequest() {
@@ -3,6 +3,7 @@
 
 #include "remote_scales.h"
 #include "remote_scales_plugin_registry.h"
+#include "remote_scales_command_queue.h"
 #include <Arduino.h>
 #include <BLEDevice.h>
 #include <BLEUtils.h>
@@ -48,13 +49,24 @@ private:
   BLERemoteService* service;
   BLERemoteCharacteristic* weightCharacteristic;
   BLERemoteCharacteristic* commandCharacteristic;
+  // The command characteristic belongs to the Microchip transparent UART service, which carries a
+  // byte stream. Frames are delimited by their EF DD header and length, not by write boundaries,
+  // so back to back frames in one write look the same to the scale as separate writes.
+  RemoteScalesCommandQueue commandQueue;
 
   bool performConnectionHandshake();
   void subscribeToNotifications();
   void log();
 
-  void sendMessage(AcaiaMessageType msgType, const uint8_t* payload, size_t length, bool waitResponse = false);
+  bool sendMessage(
+    AcaiaMessageType msgType,
+    const uint8_t* payload,
+    size_t length,
+    RemoteScalesCommandPriority priority = RemoteScalesCommandPriority::HOUSEKEEPING,
+    bool waitResponse = false
+  );
   void sendEvent(const uint8_t* payload, size_t length);
+  void flushCommands();
   void sendHeartbeat();
   void sendNotificationRequest();
   void sendId();
@@ -83,15 +95,6 @@ private:
 
 class AcaiaScalesPlugin {
 public:
-  static void apply() {
-    RemoteScalesPlugin plugin = RemoteScalesPlugin{
-      .id = "plugin-acaia",
-      .handles = [](BLEAdvertisedDevice device) { return AcaiaScalesPlugin::handles(device); },
-      .initialise = [](BLEAdvertisedDevice device) { return (RemoteScales*) new AcaiaScales(device); },
-    };
-    RemoteScalesPluginRegistry::getInstance()->registerPlugin(plugin);
-  }
-private:
   static bool handles(BLEAdvertisedDevice device) {
     std::string deviceName = device.getName();
     return !deviceName.empty() && (
@@ -100,5 +103,24 @@ private:
       || deviceName.find("LUNAR") == 0
       || deviceName.find("PROCH") == 0);
   }
+
+  static RemoteScales* initialise(BLEAdvertisedDevice device) { return new AcaiaScales(device); }
+
+  static constexpr RemoteScalesStaticPlugin staticPlugin = {
+    .id = "plugin-acaia",
+    .handles = &AcaiaScalesPlugin::handles,
+    .initialise = &AcaiaScalesPlugin::initialise,
+    .requiresScanResponse = true, // The name matched in handles() may only be sent in the scan response
+  };
+
+  static void apply() {
+    RemoteScalesPlugin plugin = RemoteScalesPlugin{
+      .id = staticPlugin.id,
+      .handles = staticPlugin.handles,
+      .initialise = staticPlugin.initialise,
+      .requiresScanResponse = staticPlugin.requiresScanResponse,
+    };
+    RemoteScalesPluginRegistry::getInstance()->registerPlugin(plugin);
+  }
 };
 #endif
@@ -0,0 +1,132 @@
+#include <unity.h>
+#include <vector>
+#include "remote_scales_command_queue.h"
+
+struct Packet {
+  std::vector<uint8_t> bytes;
+  bool withResponse;
+};
+
+static std::vector<Packet> packets;
+
+static RemoteScalesCommandQueue::PacketWriter writer() {
+  return [](uint8_t* data, size_t length, bool withResponse) {
+    packets.push_back(Packet{ std::vector<uint8_t>(data, data + length), withResponse });
+  };
+}
+
+static bool enqueue(RemoteScalesCommandQueue& queue, uint8_t id, RemoteScalesCommandPriority priority, bool requiresResponse = false) {
+  uint8_t frame[] = { 0xef, 0xdd, id };
+  return queue.enqueue(frame, sizeof(frame), priority, requiresResponse);
+}
+
+static std::vector<uint8_t> ids(const Packet& packet) {
+  std::vector<uint8_t> result;
+  for (size_t i = 2; i < packet.bytes.size(); i += 3) {
+    result.push_back(packet.bytes[i]);
+  }
+  return result;
+}
+
+void setUp(void) {
+  packets.clear();
+}
+
+void tearDown(void) {}
+
+void test_user_frames_are_sent_before_housekeeping(void) {
+  RemoteScalesCommandQueue queue;
+  enqueue(queue, 1, RemoteScalesCommandPriority::HOUSEKEEPING);
+  enqueue(queue, 2, RemoteScalesCommandPriority::USER);
+  enqueue(queue, 3, RemoteScalesCommandPriority::HOUSEKEEPING);
+
+  TEST_ASSERT_EQUAL(1, queue.flush(writer(), 20));
+  TEST_ASSERT_EQUAL(1, packets.size());
+  std::vector<uint8_t> expected = { 2, 1, 3 };
+  TEST_ASSERT_TRUE(ids(packets[0]) == expected);
+  TEST_ASSERT_FALSE(packets[0].withResponse);
+  TEST_ASSERT_TRUE(queue.isEmpty());
+}
+
+void test_frames_are_packed_up_to_packet_size(void) {
+  RemoteScalesCommandQueue queue;
+  for (uint8_t id = 1; id <= 5; id++) {
+    enqueue(queue, id, RemoteScalesCommandPriority::USER);
+  }
+
+  TEST_ASSERT_EQUAL(3, queue.flush(writer(), 7));
+  TEST_ASSERT_EQUAL(6, packets[0].bytes.size());
+  TEST_ASSERT_EQUAL(6, packets[1].bytes.size());
+  TEST_ASSERT_EQUAL(3, packets[2].bytes.size());
+}
+
+void test_frame_requiring_response_is_never_coalesced(void) {
+  RemoteScalesCommandQueue queue;
+  enqueue(queue, 1, RemoteScalesCommandPriority::USER);
+  enqueue(queue, 2, RemoteScalesCommandPriority::USER, true);
+  enqueue(queue, 3, RemoteScalesCommandPriority::USER);
+
+  TEST_ASSERT_EQUAL(3, queue.flush(writer(), 20));
+  TEST_ASSERT_EQUAL(3, packets.size());
+  TEST_ASSERT_EQUAL(3, packets[1].bytes.size());
+  TEST_ASSERT_EQUAL(2, packets[1].bytes[2]);
+  TEST_ASSERT_TRUE(packets[1].withResponse);
+  TEST_ASSERT_FALSE(packets[0].withResponse);
+  TEST_ASSERT_FALSE(packets[2].withResponse);
+}
+
+void test_identical_housekeeping_frames_are_coalesced(void) {
+  RemoteScalesCommandQueue queue;
+  TEST_ASSERT_TRUE(enqueue(queue, 1, RemoteScalesCommandPriority::HOUSEKEEPING));
+  TEST_ASSERT_TRUE(enqueue(queue, 1, RemoteScalesCommandPriority::HOUSEKEEPING));
+  TEST_ASSERT_TRUE(enqueue(queue, 1, RemoteScalesCommandPriority::USER));
+  TEST_ASSERT_TRUE(enqueue(queue, 1, RemoteScalesCommandPriority::USER));
+  TEST_ASSERT_EQUAL(3, queue.size());
+}
+
+void test_full_queue_drops_housekeeping_then_rejects_user_frames(void) {
+  RemoteScalesCommandQueue queue(true, 3);
+  enqueue(queue, 1, RemoteScalesCommandPriority::HOUSEKEEPING);
+  enqueue(queue, 2, RemoteScalesCommandPriority::HOUSEKEEPING);
+  enqueue(queue, 3, RemoteScalesCommandPriority::USER);
+
+  TEST_ASSERT_TRUE(enqueue(queue, 4, RemoteScalesCommandPriority::USER));
+  TEST_ASSERT_EQUAL_UINT32(1, queue.getDroppedFrames());
+  TEST_ASSERT_TRUE(enqueue(queue, 5, RemoteScalesCommandPriority::HOUSEKEEPING));
+  TEST_ASSERT_EQUAL_UINT32(2, queue.getDroppedFrames());
+  TEST_ASSERT_TRUE(enqueue(queue, 6, RemoteScalesCommandPriority::USER));
+  TEST_ASSERT_EQUAL_UINT32(3, queue.getDroppedFrames());
+  TEST_ASSERT_FALSE(enqueue(queue, 7, RemoteScalesCommandPriority::USER));
+  TEST_ASSERT_FALSE(enqueue(queue, 8, RemoteScalesCommandPriority::HOUSEKEEPING));
+  TEST_ASSERT_EQUAL_UINT32(5, queue.getDroppedFrames());
+  TEST_ASSERT_EQUAL(3, queue.size());
+
+  queue.flush(writer(), 20);
+  std::vector<uint8_t> expected = { 3, 4, 6 };
+  TEST_ASSERT_TRUE(ids(packets[0]) == expected);
+}
+
+void test_flush_sends_at_most_max_packets(void) {
+  RemoteScalesCommandQueue queue(false, 16, 2);
+  for (uint8_t id = 1; id <= 5; id++) {
+    enqueue(queue, id, RemoteScalesCommandPriority::USER);
+  }
+
+  TEST_ASSERT_EQUAL(2, queue.flush(writer(), 20));
+  TEST_ASSERT_EQUAL(3, queue.size());
+  TEST_ASSERT_EQUAL(2, queue.flush(writer(), 20));
+  TEST_ASSERT_EQUAL(1, queue.flush(writer(), 20));
+  TEST_ASSERT_EQUAL(5, packets.size());
+  TEST_ASSERT_EQUAL(0, queue.flush(writer(), 20));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_user_frames_are_sent_before_housekeeping);
+  RUN_TEST(test_frames_are_packed_up_to_packet_size);
+  RUN_TEST(test_frame_requiring_response_is_never_coalesced);
+  RUN_TEST(test_identical_housekeeping_frames_are_coalesced);
+  RUN_TEST(test_full_queue_drops_housekeeping_then_rejects_user_frames);
+  RUN_TEST(test_flush_sends_at_most_max_packets);
+  return UNITY_END();
+}
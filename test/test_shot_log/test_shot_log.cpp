@@ -0,0 +1,171 @@
+#include <ArduinoFake.h>
+#include <unity.h>
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include "remote_scales_shot_log.h"
+
+using namespace fakeit;
+
+class MemoryShotLogStorage : public ShotLogStorage {
+public:
+  std::vector<uint8_t> bytes;
+
+  bool append(const uint8_t* data, size_t length) override {
+    bytes.insert(bytes.end(), data, data + length);
+    return true;
+  }
+
+  size_t read(size_t offset, uint8_t* data, size_t length) override {
+    if (offset >= bytes.size()) return 0;
+    size_t available = bytes.size() - offset < length ? bytes.size() - offset : length;
+    memcpy(data, bytes.data() + offset, available);
+    return available;
+  }
+};
+
+static uint32_t now = 0;
+
+void setUp(void) {
+  ArduinoFakeReset();
+  now = 0;
+  When(Method(ArduinoFake(), millis)).AlwaysDo([]() -> unsigned long { return now; });
+}
+
+void tearDown(void) {}
+
+static void recordShot(ShotLogRecorder& recorder, uint32_t start, size_t samples) {
+  now = start;
+  recorder.startShot();
+  for (size_t i = 0; i < samples; i++) {
+    recorder.addSample(start + 100 * (i + 1), i * 0.37f - 1.f);
+    recorder.update();
+  }
+  recorder.endShot();
+}
+
+static void assertShot(ShotLogReader& reader, uint32_t start, size_t samples) {
+  uint32_t startTimestamp = 0;
+  TEST_ASSERT_TRUE(reader.nextShot(startTimestamp));
+  TEST_ASSERT_EQUAL_UINT32(start, startTimestamp);
+
+  ShotLogSample sample;
+  for (size_t i = 0; i < samples; i++) {
+    TEST_ASSERT_TRUE(reader.nextSample(sample));
+    TEST_ASSERT_EQUAL_UINT32(100 * (i + 1), sample.timestamp);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, i * 0.37f - 1.f, sample.weight);
+  }
+  TEST_ASSERT_FALSE(reader.nextSample(sample));
+}
+
+void test_round_trip_multiple_shots(void) {
+  MemoryShotLogStorage storage;
+  ShotLogRecorder recorder(storage);
+  recordShot(recorder, 1000, 400);
+  recordShot(recorder, 90000, 3);
+  recordShot(recorder, 200000, 0);
+
+  ShotLogReader reader(storage);
+  assertShot(reader, 1000, 400);
+  assertShot(reader, 90000, 3);
+  assertShot(reader, 200000, 0);
+  uint32_t startTimestamp;
+  TEST_ASSERT_FALSE(reader.nextShot(startTimestamp));
+}
+
+void test_samples_outside_of_shot_are_ignored(void) {
+  MemoryShotLogStorage storage;
+  ShotLogRecorder recorder(storage);
+  recorder.addSample(10, 1.f);
+  recordShot(recorder, 500, 2);
+  recorder.addSample(2000, 1.f);
+  recorder.update();
+
+  ShotLogReader reader(storage);
+  assertShot(reader, 500, 2);
+}
+
+void test_sample_before_shot_start_is_not_wrapped(void) {
+  MemoryShotLogStorage storage;
+  ShotLogRecorder recorder(storage);
+  now = 200000;
+  recorder.startShot();
+  recorder.addSample(199990, 1.f);
+  recorder.addSample(200100, 2.f);
+  recorder.endShot();
+
+  ShotLogReader reader(storage);
+  uint32_t startTimestamp;
+  ShotLogSample sample;
+  TEST_ASSERT_TRUE(reader.nextShot(startTimestamp));
+  TEST_ASSERT_TRUE(reader.nextSample(sample));
+  TEST_ASSERT_EQUAL_UINT32(0, sample.timestamp);
+  TEST_ASSERT_TRUE(reader.nextSample(sample));
+  TEST_ASSERT_EQUAL_UINT32(100, sample.timestamp);
+}
+
+void test_samples_are_dropped_until_update(void) {
+  MemoryShotLogStorage storage;
+  ShotLogRecorder recorder(storage);
+  recorder.startShot();
+  for (uint32_t i = 0; i < 1000; i++) {
+    recorder.addSample(i, 1.f);
+  }
+  TEST_ASSERT_EQUAL(0, storage.bytes.size());
+  TEST_ASSERT_GREATER_THAN_UINT32(0, recorder.getDroppedSamples());
+
+  recorder.update();
+  TEST_ASSERT_EQUAL(ShotLogRecorder::PAGE_SIZE, storage.bytes.size());
+  uint32_t dropped = recorder.getDroppedSamples();
+  recorder.addSample(1000, 1.f);
+  TEST_ASSERT_EQUAL_UINT32(dropped, recorder.getDroppedSamples());
+  recorder.endShot();
+}
+
+void test_write_amplification_is_bounded(void) {
+  MemoryShotLogStorage storage;
+  ShotLogRecorder recorder(storage);
+  const uint32_t shots = 5;
+  for (uint32_t shot = 0; shot < shots; shot++) {
+    recordShot(recorder, shot * 100000, 300);
+  }
+
+  const size_t usable = ShotLogRecorder::PAGE_SIZE - ShotLogRecorder::PAGE_HEADER_SIZE - ShotLogRecorder::MAX_RECORD_SIZE + 1;
+  uint32_t bound = recorder.getBytesEncoded() * ShotLogRecorder::PAGE_SIZE / usable + shots * ShotLogRecorder::PAGE_SIZE;
+  TEST_ASSERT_EQUAL(recorder.getBytesWritten(), storage.bytes.size());
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(bound, recorder.getBytesWritten());
+  TEST_ASSERT_EQUAL_UINT32(0, recorder.getDroppedSamples());
+}
+
+void test_file_storage_appends_after_read(void) {
+  const char* path = "test_shot_log.bin";
+  remove(path);
+  {
+    FileShotLogStorage storage(path);
+    TEST_ASSERT_TRUE(storage.isOpen());
+    ShotLogRecorder recorder(storage);
+    recordShot(recorder, 1000, 50);
+
+    ShotLogReader firstPass(storage);
+    assertShot(firstPass, 1000, 50);
+
+    recordShot(recorder, 5000, 20);
+  }
+
+  FileShotLogStorage storage(path);
+  ShotLogReader reader(storage);
+  assertShot(reader, 1000, 50);
+  assertShot(reader, 5000, 20);
+  remove(path);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip_multiple_shots);
+  RUN_TEST(test_samples_outside_of_shot_are_ignored);
+  RUN_TEST(test_sample_before_shot_start_is_not_wrapped);
+  RUN_TEST(test_samples_are_dropped_until_update);
+  RUN_TEST(test_write_amplification_is_bounded);
+  RUN_TEST(test_file_storage_appends_after_read);
+  return UNITY_END();
+}